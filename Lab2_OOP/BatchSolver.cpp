@@ -0,0 +1,517 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Instrumentation.cpp"
+#include "Matrix.cpp"
+#include "Vector.cpp"
+
+#if defined(__AVX__)
+#define BATCH_SOLVER_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BATCH_SOLVER_SSE2
+#include <emmintrin.h>
+#endif
+
+// Arithmetic on a pack of lanes, one lane per system. The scalar version
+// holds a single system and is used for other types and for the batch tail.
+template <typename T>
+struct ScalarLanes {
+    typedef T Pack;
+    typedef bool Mask;
+    static const size_t width = 1;
+
+    static Pack load(const T* source) { return *source; }
+    static void store(T* destination, Pack value) { *destination = value; }
+    static Pack broadcast(T value) { return value; }
+
+    static Pack add(Pack a, Pack b) { return a + b; }
+    static Pack subtract(Pack a, Pack b) { return a - b; }
+    static Pack multiply(Pack a, Pack b) { return a * b; }
+    static Pack divide(Pack a, Pack b) { return a / b; }
+    static Pack absolute(Pack a) { return std::abs(a); }
+    static Pack maximum(Pack a, Pack b) { return a > b ? a : b; }
+
+    static Mask greater(Pack a, Pack b) { return a > b; }
+    static Mask notGreater(Pack a, Pack b) { return !(a > b); }
+    static Mask either(Mask a, Mask b) { return a || b; }
+    static Mask none() { return false; }
+    static bool any(Mask mask) { return mask; }
+    static Pack select(Mask mask, Pack ifTrue, Pack ifFalse) { return mask ? ifTrue : ifFalse; }
+    static void storeMask(unsigned char* destination, Mask mask) { *destination = mask; }
+};
+
+template <typename T>
+struct BatchLanes : ScalarLanes<T> {
+};
+
+// Writes one flag byte per lane from a movemask value, four lanes per table row
+inline void storeLaneFlags(unsigned char* destination, int bits, size_t width) {
+    static const unsigned char flags[16][4] = {
+        { 0, 0, 0, 0 }, { 1, 0, 0, 0 }, { 0, 1, 0, 0 }, { 1, 1, 0, 0 },
+        { 0, 0, 1, 0 }, { 1, 0, 1, 0 }, { 0, 1, 1, 0 }, { 1, 1, 1, 0 },
+        { 0, 0, 0, 1 }, { 1, 0, 0, 1 }, { 0, 1, 0, 1 }, { 1, 1, 0, 1 },
+        { 0, 0, 1, 1 }, { 1, 0, 1, 1 }, { 0, 1, 1, 1 }, { 1, 1, 1, 1 }
+    };
+    for (size_t lane = 0; lane < width; lane += 4) {
+        std::memcpy(destination + lane, flags[(bits >> lane) & 15], std::min<size_t>(width - lane, 4));
+    }
+}
+
+#ifdef BATCH_SOLVER_AVX
+template <>
+struct BatchLanes<double> {
+    typedef __m256d Pack;
+    typedef __m256d Mask;
+    static const size_t width = 4;
+
+    static Pack load(const double* source) { return _mm256_loadu_pd(source); }
+    static void store(double* destination, Pack value) { _mm256_storeu_pd(destination, value); }
+    static Pack broadcast(double value) { return _mm256_set1_pd(value); }
+
+    static Pack add(Pack a, Pack b) { return _mm256_add_pd(a, b); }
+    static Pack subtract(Pack a, Pack b) { return _mm256_sub_pd(a, b); }
+    static Pack multiply(Pack a, Pack b) { return _mm256_mul_pd(a, b); }
+    static Pack divide(Pack a, Pack b) { return _mm256_div_pd(a, b); }
+    static Pack absolute(Pack a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static Pack maximum(Pack a, Pack b) { return _mm256_max_pd(a, b); }
+
+    static Mask greater(Pack a, Pack b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static Mask notGreater(Pack a, Pack b) { return _mm256_cmp_pd(a, b, _CMP_NGT_UQ); }
+    static Mask either(Mask a, Mask b) { return _mm256_or_pd(a, b); }
+    static Mask none() { return _mm256_setzero_pd(); }
+    static bool any(Mask mask) { return _mm256_movemask_pd(mask) != 0; }
+    static Pack select(Mask mask, Pack ifTrue, Pack ifFalse) { return _mm256_blendv_pd(ifFalse, ifTrue, mask); }
+    static void storeMask(unsigned char* destination, Mask mask) {
+        storeLaneFlags(destination, _mm256_movemask_pd(mask), width);
+    }
+};
+
+template <>
+struct BatchLanes<float> {
+    typedef __m256 Pack;
+    typedef __m256 Mask;
+    static const size_t width = 8;
+
+    static Pack load(const float* source) { return _mm256_loadu_ps(source); }
+    static void store(float* destination, Pack value) { _mm256_storeu_ps(destination, value); }
+    static Pack broadcast(float value) { return _mm256_set1_ps(value); }
+
+    static Pack add(Pack a, Pack b) { return _mm256_add_ps(a, b); }
+    static Pack subtract(Pack a, Pack b) { return _mm256_sub_ps(a, b); }
+    static Pack multiply(Pack a, Pack b) { return _mm256_mul_ps(a, b); }
+    static Pack divide(Pack a, Pack b) { return _mm256_div_ps(a, b); }
+    static Pack absolute(Pack a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static Pack maximum(Pack a, Pack b) { return _mm256_max_ps(a, b); }
+
+    static Mask greater(Pack a, Pack b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Mask notGreater(Pack a, Pack b) { return _mm256_cmp_ps(a, b, _CMP_NGT_UQ); }
+    static Mask either(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+    static Mask none() { return _mm256_setzero_ps(); }
+    static bool any(Mask mask) { return _mm256_movemask_ps(mask) != 0; }
+    static Pack select(Mask mask, Pack ifTrue, Pack ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, mask); }
+    static void storeMask(unsigned char* destination, Mask mask) {
+        storeLaneFlags(destination, _mm256_movemask_ps(mask), width);
+    }
+};
+#elif defined(BATCH_SOLVER_SSE2)
+template <>
+struct BatchLanes<double> {
+    typedef __m128d Pack;
+    typedef __m128d Mask;
+    static const size_t width = 2;
+
+    static Pack load(const double* source) { return _mm_loadu_pd(source); }
+    static void store(double* destination, Pack value) { _mm_storeu_pd(destination, value); }
+    static Pack broadcast(double value) { return _mm_set1_pd(value); }
+
+    static Pack add(Pack a, Pack b) { return _mm_add_pd(a, b); }
+    static Pack subtract(Pack a, Pack b) { return _mm_sub_pd(a, b); }
+    static Pack multiply(Pack a, Pack b) { return _mm_mul_pd(a, b); }
+    static Pack divide(Pack a, Pack b) { return _mm_div_pd(a, b); }
+    static Pack absolute(Pack a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static Pack maximum(Pack a, Pack b) { return _mm_max_pd(a, b); }
+
+    static Mask greater(Pack a, Pack b) { return _mm_cmpgt_pd(a, b); }
+    static Mask notGreater(Pack a, Pack b) { return _mm_cmpngt_pd(a, b); }
+    static Mask either(Mask a, Mask b) { return _mm_or_pd(a, b); }
+    static Mask none() { return _mm_setzero_pd(); }
+    static bool any(Mask mask) { return _mm_movemask_pd(mask) != 0; }
+    static Pack select(Mask mask, Pack ifTrue, Pack ifFalse) {
+        return _mm_or_pd(_mm_and_pd(mask, ifTrue), _mm_andnot_pd(mask, ifFalse));
+    }
+    static void storeMask(unsigned char* destination, Mask mask) {
+        storeLaneFlags(destination, _mm_movemask_pd(mask), width);
+    }
+};
+
+template <>
+struct BatchLanes<float> {
+    typedef __m128 Pack;
+    typedef __m128 Mask;
+    static const size_t width = 4;
+
+    static Pack load(const float* source) { return _mm_loadu_ps(source); }
+    static void store(float* destination, Pack value) { _mm_storeu_ps(destination, value); }
+    static Pack broadcast(float value) { return _mm_set1_ps(value); }
+
+    static Pack add(Pack a, Pack b) { return _mm_add_ps(a, b); }
+    static Pack subtract(Pack a, Pack b) { return _mm_sub_ps(a, b); }
+    static Pack multiply(Pack a, Pack b) { return _mm_mul_ps(a, b); }
+    static Pack divide(Pack a, Pack b) { return _mm_div_ps(a, b); }
+    static Pack absolute(Pack a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static Pack maximum(Pack a, Pack b) { return _mm_max_ps(a, b); }
+
+    static Mask greater(Pack a, Pack b) { return _mm_cmpgt_ps(a, b); }
+    static Mask notGreater(Pack a, Pack b) { return _mm_cmpngt_ps(a, b); }
+    static Mask either(Mask a, Mask b) { return _mm_or_ps(a, b); }
+    static Mask none() { return _mm_setzero_ps(); }
+    static bool any(Mask mask) { return _mm_movemask_ps(mask) != 0; }
+    static Pack select(Mask mask, Pack ifTrue, Pack ifFalse) {
+        return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+    }
+    static void storeMask(unsigned char* destination, Mask mask) {
+        storeLaneFlags(destination, _mm_movemask_ps(mask), width);
+    }
+};
+#endif
+
+// Solves many N x N systems A x = b of the same shape at once. Inputs are kept
+// as structure-of-arrays: plane (i * N + j) of coefficients holds A[i][j] of
+// every system, plane i of constants holds b[i] of every system.
+template <typename T, size_t N>
+class BatchSolver {
+    static_assert(std::is_floating_point<T>::value, "Batch solver requires a floating-point element type");
+    static_assert(N > 0, "Batch solver systems must have at least one unknown");
+
+private:
+    size_t count;
+
+public:
+    std::vector<T> coefficients;
+    std::vector<T> constants;
+    std::vector<T> solutions;
+    std::vector<unsigned char> singular;
+
+
+    // Constructor
+    BatchSolver(size_t numSystems) : count(numSystems) {
+        coefficients.resize(N * N * count);
+        constants.resize(N * count);
+        solutions.resize(N * count);
+        singular.resize(count);
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    T& coefficient(size_t system, size_t row, size_t column) {
+        return coefficients[(row * N + column) * count + system];
+    }
+
+    T& constant(size_t system, size_t row) {
+        return constants[row * count + system];
+    }
+
+    T solution(size_t system, size_t row) const {
+        return solutions[row * count + system];
+    }
+
+    bool isSingular(size_t system) const {
+        return singular[system] != 0;
+    }
+
+    // Scatter one fixed-size system into the batch
+    void setSystem(size_t system, const Matrix<T, N, N>& a, const Vector<T, N>& b) {
+        for (size_t i = 0; i < N; ++i) {
+            for (size_t j = 0; j < N; ++j) {
+                coefficient(system, i, j) = a[i][j];
+            }
+            constant(system, i) = b[i];
+        }
+    }
+
+    // Gather the solution of one system
+    Vector<T, N> getSolution(size_t system) const {
+        Vector<T, N> result;
+        for (size_t i = 0; i < N; ++i) {
+            result[i] = solution(system, i);
+        }
+        return result;
+    }
+
+    // Solves every system. A singular system, or one whose input or solution is
+    // not finite, gets a zero solution and its flag set instead of aborting the
+    // batch. numThreads of 0 picks the hardware count.
+    void solve(unsigned numThreads = 0) {
+        INSTRUMENT_TIME(BatchSolve);
+        const size_t width = BatchLanes<T>::width;
+        const size_t minSystemsPerThread = 1024;
+
+        if (numThreads == 0) {
+            numThreads = std::thread::hardware_concurrency();
+        }
+        size_t maxThreads = count / minSystemsPerThread;
+        if (numThreads > maxThreads) {
+            numThreads = (unsigned)maxThreads;
+        }
+        if (numThreads <= 1) {
+            solveRange(0, count);
+            return;
+        }
+
+        // Chunk boundaries are kept on whole packs so only the last chunk has a tail
+        size_t packs = (count + width - 1) / width;
+        size_t packsPerThread = (packs + numThreads - 1) / numThreads;
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < numThreads; ++t) {
+            size_t begin = std::min(count, t * packsPerThread * width);
+            size_t end = std::min(count, (t + 1) * packsPerThread * width);
+            if (begin < end) {
+                workers.emplace_back(&BatchSolver::solveRange, this, begin, end);
+            }
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+private:
+    // The planes as raw pointers. The kernels work on a local copy, so the
+    // byte-sized flag stores do not force the vectors to be reloaded per group.
+    struct Planes {
+        const T* coefficients;
+        const T* constants;
+        T* solutions;
+        unsigned char* singular;
+        size_t count;
+    };
+
+    void solveRange(size_t begin, size_t end) {
+        const size_t width = BatchLanes<T>::width;
+        const Planes planes = { coefficients.data(), constants.data(), solutions.data(), singular.data(), count };
+        size_t system = begin;
+        for (; system + width <= end; system += width) {
+            solveGroup<BatchLanes<T>>(planes, system);
+        }
+        for (; system < end; ++system) {
+            solveGroup<ScalarLanes<T>>(planes, system);
+        }
+    }
+
+    // Solves Lanes::width systems at once: closed form for 2x2 and 3x3, scaled
+    // partial pivoting otherwise. Tag 0 selects the general elimination.
+    template <typename Lanes>
+    static void solveGroup(const Planes& planes, size_t system) {
+        solveLanes<Lanes>(planes, system, std::integral_constant<size_t, (N == 2 || N == 3) ? N : 0>());
+    }
+
+    template <typename Lanes>
+    static typename Lanes::Pack loadCoefficient(const Planes& planes, size_t system, size_t row, size_t column) {
+        return Lanes::load(&planes.coefficients[(row * N + column) * planes.count + system]);
+    }
+
+    template <typename Lanes>
+    static typename Lanes::Pack loadConstant(const Planes& planes, size_t system, size_t row) {
+        return Lanes::load(&planes.constants[row * planes.count + system]);
+    }
+
+    // Writes the solutions of the group, zero for flagged lanes, and the flags.
+    // NaN or infinity anywhere in the input ends up in the solution, where a
+    // single sum of the components is enough to see it.
+    template <typename Lanes>
+    static void storeSolution(const Planes& planes, size_t system, const typename Lanes::Pack (&solution)[N],
+                              typename Lanes::Mask isSingular) {
+        typename Lanes::Pack sum = solution[0];
+        for (size_t i = 1; i < N; ++i) {
+            sum = Lanes::add(sum, solution[i]);
+        }
+        const typename Lanes::Pack largest = Lanes::broadcast(std::numeric_limits<T>::max());
+        isSingular = Lanes::either(isSingular, Lanes::notGreater(largest, Lanes::absolute(sum)));
+
+        for (size_t i = 0; i < N; ++i) {
+            Lanes::store(&planes.solutions[i * planes.count + system], Lanes::select(isSingular, Lanes::broadcast(0), solution[i]));
+        }
+        Lanes::storeMask(&planes.singular[system], isSingular);
+    }
+
+    // a * b - c * d on every lane
+    template <typename Lanes>
+    static typename Lanes::Pack crossDifference(typename Lanes::Pack a, typename Lanes::Pack b,
+                                                typename Lanes::Pack c, typename Lanes::Pack d) {
+        return Lanes::subtract(Lanes::multiply(a, b), Lanes::multiply(c, d));
+    }
+
+    // Flags lanes whose determinant vanishes relative to the bound on its terms,
+    // and returns the reciprocal of the determinant. Flagged lanes may divide by
+    // zero; their solutions are replaced at the store.
+    template <typename Lanes>
+    static typename Lanes::Pack inverseDeterminant(typename Lanes::Pack determinant, typename Lanes::Pack bound,
+                                                   typename Lanes::Mask& isSingular) {
+        typename Lanes::Pack tolerance = Lanes::multiply(bound, Lanes::broadcast(N * std::numeric_limits<T>::epsilon()));
+        isSingular = Lanes::notGreater(Lanes::absolute(determinant), tolerance);
+        return Lanes::divide(Lanes::broadcast(1), determinant);
+    }
+
+    template <typename Lanes>
+    static void solveLanes(const Planes& planes, size_t system, std::integral_constant<size_t, 2>) {
+        typedef typename Lanes::Pack Pack;
+        Pack a00 = loadCoefficient<Lanes>(planes, system, 0, 0);
+        Pack a01 = loadCoefficient<Lanes>(planes, system, 0, 1);
+        Pack a10 = loadCoefficient<Lanes>(planes, system, 1, 0);
+        Pack a11 = loadCoefficient<Lanes>(planes, system, 1, 1);
+        Pack b0 = loadConstant<Lanes>(planes, system, 0);
+        Pack b1 = loadConstant<Lanes>(planes, system, 1);
+
+        // Rounding in the determinant is bounded by its two products, which
+        // scale with each row just as the determinant does
+        Pack diagonal = Lanes::multiply(a00, a11);
+        Pack antidiagonal = Lanes::multiply(a01, a10);
+        typename Lanes::Mask isSingular;
+        Pack inverse = inverseDeterminant<Lanes>(Lanes::subtract(diagonal, antidiagonal),
+                                                 Lanes::add(Lanes::absolute(diagonal), Lanes::absolute(antidiagonal)), isSingular);
+
+        Pack solution[N] = {
+            Lanes::multiply(crossDifference<Lanes>(b0, a11, a01, b1), inverse),
+            Lanes::multiply(crossDifference<Lanes>(a00, b1, a10, b0), inverse)
+        };
+        storeSolution<Lanes>(planes, system, solution, isSingular);
+    }
+
+    // Largest magnitude of a row of three
+    template <typename Lanes>
+    static typename Lanes::Pack rowScale(typename Lanes::Pack a, typename Lanes::Pack b, typename Lanes::Pack c) {
+        return Lanes::maximum(Lanes::maximum(Lanes::absolute(a), Lanes::absolute(b)), Lanes::absolute(c));
+    }
+
+    template <typename Lanes>
+    static void solveLanes(const Planes& planes, size_t system, std::integral_constant<size_t, 3>) {
+        typedef typename Lanes::Pack Pack;
+        Pack a00 = loadCoefficient<Lanes>(planes, system, 0, 0);
+        Pack a01 = loadCoefficient<Lanes>(planes, system, 0, 1);
+        Pack a02 = loadCoefficient<Lanes>(planes, system, 0, 2);
+        Pack a10 = loadCoefficient<Lanes>(planes, system, 1, 0);
+        Pack a11 = loadCoefficient<Lanes>(planes, system, 1, 1);
+        Pack a12 = loadCoefficient<Lanes>(planes, system, 1, 2);
+        Pack a20 = loadCoefficient<Lanes>(planes, system, 2, 0);
+        Pack a21 = loadCoefficient<Lanes>(planes, system, 2, 1);
+        Pack a22 = loadCoefficient<Lanes>(planes, system, 2, 2);
+
+        // Cofactors of A; x = adj(A) b / det(A), with singularity judged against
+        // the product of the row scales
+        Pack c00 = crossDifference<Lanes>(a11, a22, a12, a21);
+        Pack c01 = crossDifference<Lanes>(a12, a20, a10, a22);
+        Pack c02 = crossDifference<Lanes>(a10, a21, a11, a20);
+        Pack c10 = crossDifference<Lanes>(a02, a21, a01, a22);
+        Pack c11 = crossDifference<Lanes>(a00, a22, a02, a20);
+        Pack c12 = crossDifference<Lanes>(a01, a20, a00, a21);
+        Pack c20 = crossDifference<Lanes>(a01, a12, a02, a11);
+        Pack c21 = crossDifference<Lanes>(a02, a10, a00, a12);
+        Pack c22 = crossDifference<Lanes>(a00, a11, a01, a10);
+
+        Pack determinant = Lanes::add(Lanes::add(Lanes::multiply(a00, c00), Lanes::multiply(a01, c01)),
+                                      Lanes::multiply(a02, c02));
+        Pack scaleProduct = Lanes::multiply(Lanes::multiply(rowScale<Lanes>(a00, a01, a02), rowScale<Lanes>(a10, a11, a12)),
+                                            rowScale<Lanes>(a20, a21, a22));
+        typename Lanes::Mask isSingular;
+        Pack inverse = inverseDeterminant<Lanes>(determinant, scaleProduct, isSingular);
+
+        Pack b0 = loadConstant<Lanes>(planes, system, 0);
+        Pack b1 = loadConstant<Lanes>(planes, system, 1);
+        Pack b2 = loadConstant<Lanes>(planes, system, 2);
+        Pack solution[N] = {
+            Lanes::multiply(Lanes::add(Lanes::add(Lanes::multiply(c00, b0), Lanes::multiply(c10, b1)), Lanes::multiply(c20, b2)), inverse),
+            Lanes::multiply(Lanes::add(Lanes::add(Lanes::multiply(c01, b0), Lanes::multiply(c11, b1)), Lanes::multiply(c21, b2)), inverse),
+            Lanes::multiply(Lanes::add(Lanes::add(Lanes::multiply(c02, b0), Lanes::multiply(c12, b1)), Lanes::multiply(c22, b2)), inverse)
+        };
+        storeSolution<Lanes>(planes, system, solution, isSingular);
+    }
+
+    // Gaussian elimination with scaled partial pivoting. Row swaps differ between
+    // lanes, so they are done with per-lane selects, skipped when no lane swaps.
+    template <typename Lanes>
+    static void solveLanes(const Planes& planes, size_t system, std::integral_constant<size_t, 0>) {
+        typedef typename Lanes::Pack Pack;
+        typedef typename Lanes::Mask Mask;
+
+        // Augmented matrix [A|b]. rowScale, the largest magnitude in each row,
+        // orders the pivots so badly scaled rows are not mistaken for small ones.
+        Pack augmentedMatrix[N][N + 1];
+        Pack rowScale[N];
+        for (size_t i = 0; i < N; ++i) {
+            rowScale[i] = Lanes::broadcast(0);
+            for (size_t j = 0; j < N; ++j) {
+                augmentedMatrix[i][j] = loadCoefficient<Lanes>(planes, system, i, j);
+                rowScale[i] = Lanes::maximum(rowScale[i], Lanes::absolute(augmentedMatrix[i][j]));
+            }
+            augmentedMatrix[i][N] = loadConstant<Lanes>(planes, system, i);
+        }
+
+        // rowBound adds up the magnitude of every term cancelled into the row, so
+        // the pivot tolerance tracks accumulated roundoff
+        Pack rowBound[N];
+        for (size_t i = 0; i < N; ++i) {
+            rowBound[i] = rowScale[i];
+        }
+        const Pack epsilon = Lanes::broadcast(N * N * std::numeric_limits<T>::epsilon());
+        Pack inversePivot[N];
+        Pack solution[N];
+        Mask isSingular = Lanes::none();
+
+        // Forward elimination
+        for (size_t i = 0; i < N; ++i) {
+            // Bring the entry of column i that is largest relative to its row into row i
+            for (size_t j = i + 1; j < N; ++j) {
+                Mask swap = Lanes::greater(Lanes::multiply(Lanes::absolute(augmentedMatrix[j][i]), rowScale[i]),
+                                           Lanes::multiply(Lanes::absolute(augmentedMatrix[i][i]), rowScale[j]));
+                if (!Lanes::any(swap)) {
+                    continue;
+                }
+                for (size_t k = i; k < N + 1; ++k) {
+                    Pack upper = augmentedMatrix[i][k];
+                    Pack lower = augmentedMatrix[j][k];
+                    augmentedMatrix[i][k] = Lanes::select(swap, lower, upper);
+                    augmentedMatrix[j][k] = Lanes::select(swap, upper, lower);
+                }
+                Pack upperScale = rowScale[i];
+                rowScale[i] = Lanes::select(swap, rowScale[j], upperScale);
+                rowScale[j] = Lanes::select(swap, upperScale, rowScale[j]);
+                Pack upperBound = rowBound[i];
+                rowBound[i] = Lanes::select(swap, rowBound[j], upperBound);
+                rowBound[j] = Lanes::select(swap, upperBound, rowBound[j]);
+            }
+
+            // Flag lanes with a vanishing or non-finite pivot
+            Pack tolerance = Lanes::multiply(rowBound[i], epsilon);
+            isSingular = Lanes::either(isSingular, Lanes::notGreater(Lanes::absolute(augmentedMatrix[i][i]), tolerance));
+            inversePivot[i] = Lanes::divide(Lanes::broadcast(1), augmentedMatrix[i][i]);
+
+            for (size_t j = i + 1; j < N; ++j) {
+                Pack ratio = Lanes::multiply(augmentedMatrix[j][i], inversePivot[i]);
+                rowBound[j] = Lanes::add(rowBound[j], Lanes::multiply(Lanes::absolute(ratio), rowBound[i]));
+                for (size_t k = i + 1; k < N + 1; ++k) {
+                    augmentedMatrix[j][k] = Lanes::subtract(augmentedMatrix[j][k], Lanes::multiply(ratio, augmentedMatrix[i][k]));
+                }
+            }
+        }
+
+        // Back substitution
+        for (size_t i = N; i-- > 0;) {
+            Pack sum = augmentedMatrix[i][N];
+            for (size_t j = i + 1; j < N; ++j) {
+                sum = Lanes::subtract(sum, Lanes::multiply(augmentedMatrix[i][j], solution[j]));
+            }
+            solution[i] = Lanes::multiply(sum, inversePivot[i]);
+        }
+
+        storeSolution<Lanes>(planes, system, solution, isSingular);
+    }
+};
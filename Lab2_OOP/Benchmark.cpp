@@ -0,0 +1,279 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#if !defined(__GNUC__)
+#include <intrin.h>
+#endif
+
+#include "Instrumentation.cpp"
+#include "LongInteger.cpp"
+#include "Rational.cpp"
+#include "Matrix.cpp"
+#include "Vector.cpp"
+#include "BatchSolver.cpp"
+
+// Micro-benchmarks for LongInteger, Rational and Matrix. Every measurement is
+// written as one JSON object per line:
+// {"suite":...,"operation":...,"type":...,"size":...,"iterations":...,"ns_per_op":...}
+class Benchmark {
+public:
+    static int run(std::ostream& os) {
+        Instrumentation::reset();
+
+        benchmarkLongInteger(os);
+        benchmarkRational(os);
+        benchmarkMatrix(os);
+
+#if defined(LAB2_INSTRUMENTATION) || defined(LAB2_INSTRUMENTATION_TIMING)
+        os << "{\"instrumentation\":";
+        Instrumentation::report(os);
+        os << "}" << std::endl;
+#endif
+        return 0;
+    }
+
+private:
+    static const size_t poolSize = 8;
+
+    // Runs op(i) until at least minSeconds have elapsed, doubling the iteration
+    // count each round. unitsPerCall scales ns_per_op for batched operations.
+    template <typename Operation>
+    static void measure(std::ostream& os, const char* suite, const char* operation, const char* type,
+                        size_t size, Operation op, size_t unitsPerCall = 1) {
+        const double minSeconds = 0.05;
+        const size_t maxIterations = size_t(1) << 24;
+
+        op(0);
+
+        size_t iterations = 1;
+        double elapsed = 0;
+        for (;;) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                op(i);
+            }
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (elapsed >= minSeconds || iterations >= maxIterations) {
+                break;
+            }
+            iterations *= 2;
+        }
+
+        os << "{\"suite\":\"" << suite << "\",\"operation\":\"" << operation << "\",\"type\":\"" << type
+           << "\",\"size\":" << size << ",\"iterations\":" << iterations * unitsPerCall
+           << ",\"ns_per_op\":" << elapsed * 1e9 / (iterations * unitsPerCall) << "}" << std::endl;
+    }
+
+    // Compiler barrier: the whole result, including any heap storage it owns,
+    // has to be materialized because the optimizer must assume it is read here
+    template <typename T>
+    static void keep(const T& value) {
+#if defined(__GNUC__)
+        asm volatile("" : : "r"(&value) : "memory");
+#else
+        static const void* volatile sink;
+        sink = &value;
+        _ReadWriteBarrier();
+#endif
+    }
+
+    static std::mt19937& generator() {
+        static std::mt19937 instance(2023);
+        return instance;
+    }
+
+    // Random non-zero LongInteger with exactly the given number of limbs
+    static LongInteger randomLongInteger(size_t limbs) {
+        std::uniform_int_distribution<int> limb(1, 9999);
+        LongInteger result;
+        for (size_t i = 0; i < limbs; ++i) {
+            result = result * 10000 + LongInteger(limb(generator()));
+        }
+        return result;
+    }
+
+    template <typename T>
+    static T randomElement() {
+        std::uniform_real_distribution<double> value(-9, 9);
+        return T(value(generator()));
+    }
+
+    template <typename T>
+    static Matrix<T> randomMatrix(size_t size) {
+        Matrix<T> result(size, size);
+        for (size_t i = 0; i < size; ++i) {
+            for (size_t j = 0; j < size; ++j) {
+                result[i][j] = randomElement<T>();
+            }
+            // Diagonal dominance keeps the systems well conditioned
+            result[i][i] = result[i][i] + T(size);
+        }
+        return result;
+    }
+
+    template <typename T, size_t N>
+    static Vector<T, N> ones() {
+        Vector<T, N> result;
+        for (size_t i = 0; i < N; ++i) {
+            result[i] = T(1);
+        }
+        return result;
+    }
+
+    template <typename T, size_t N>
+    static Matrix<T, N, N> randomFixedMatrix() {
+        return Matrix<T, N, N>(randomMatrix<T>(N));
+    }
+
+    static void benchmarkLongInteger(std::ostream& os) {
+        const size_t sizes[] = { 1, 4, 16, 64, 256 };
+        for (size_t size : sizes) {
+            // a[k] > b[k], so subtraction and division stay non-negative
+            std::vector<LongInteger> a, b;
+            for (size_t k = 0; k < poolSize; ++k) {
+                a.push_back(randomLongInteger(size + 1));
+                b.push_back(randomLongInteger(size));
+            }
+
+            measure(os, "LongInteger", "add", "LongInteger", size,
+                [&](size_t i) { keep(a[i % poolSize] + b[i % poolSize]); });
+            measure(os, "LongInteger", "subtract", "LongInteger", size,
+                [&](size_t i) { keep(a[i % poolSize] - b[i % poolSize]); });
+            measure(os, "LongInteger", "multiply", "LongInteger", size,
+                [&](size_t i) { keep(a[i % poolSize] * b[i % poolSize]); });
+            measure(os, "LongInteger", "divide", "LongInteger", size,
+                [&](size_t i) { keep(a[i % poolSize] / b[i % poolSize]); });
+        }
+
+        // Remainder subtracts the divisor one step at a time, so it is kept to small operands
+        const size_t moduloSizes[] = { 1, 2 };
+        for (size_t size : moduloSizes) {
+            std::vector<LongInteger> a, b;
+            for (size_t k = 0; k < poolSize; ++k) {
+                a.push_back(randomLongInteger(size));
+                b.push_back(randomLongInteger(1));
+            }
+
+            measure(os, "LongInteger", "modulo", "LongInteger", size,
+                [&](size_t i) { keep(a[i % poolSize] % b[i % poolSize]); });
+        }
+    }
+
+    template <typename T>
+    static void benchmarkRationalType(std::ostream& os, const char* type, const std::vector<T>& values) {
+        std::vector<Rational<T>> a, b;
+        for (size_t k = 0; k < poolSize; ++k) {
+            a.push_back(Rational<T>(values[k], values[(k + 1) % poolSize]));
+            b.push_back(Rational<T>(values[(k + 2) % poolSize], values[(k + 3) % poolSize]));
+        }
+
+        measure(os, "Rational", "simplify", type, 1,
+            [&](size_t i) { keep(Rational<T>(values[i % poolSize], values[(i + 1) % poolSize])); });
+        measure(os, "Rational", "add", type, 1,
+            [&](size_t i) { keep(a[i % poolSize] + b[i % poolSize]); });
+        measure(os, "Rational", "multiply", type, 1,
+            [&](size_t i) { keep(a[i % poolSize] * b[i % poolSize]); });
+        measure(os, "Rational", "divide", type, 1,
+            [&](size_t i) { keep(a[i % poolSize] / b[i % poolSize]); });
+    }
+
+    static void benchmarkRational(std::ostream& os) {
+        std::uniform_int_distribution<long long> value(1, 9999);
+        std::vector<long long> small;
+        std::vector<LongInteger> large;
+        for (size_t k = 0; k < poolSize; ++k) {
+            small.push_back(value(generator()));
+            large.push_back(LongInteger(small.back()));
+        }
+
+        benchmarkRationalType(os, "long long", small);
+        benchmarkRationalType(os, "LongInteger", large);
+    }
+
+    template <typename T>
+    static void benchmarkDynamicMatrix(std::ostream& os, const char* type, const std::vector<size_t>& sizes) {
+        for (size_t size : sizes) {
+            std::vector<Matrix<T>> a, b;
+            std::vector<std::vector<T>> rhs;
+            for (size_t k = 0; k < poolSize; ++k) {
+                a.push_back(randomMatrix<T>(size));
+                b.push_back(randomMatrix<T>(size));
+                rhs.push_back(std::vector<T>(size, T(1)));
+            }
+
+            measure(os, "Matrix", "multiply", type, size,
+                [&](size_t i) { keep(a[i % poolSize] * b[i % poolSize]); });
+            measure(os, "Matrix", "solve", type, size,
+                [&](size_t i) { keep(a[i % poolSize].solveEquations(rhs[i % poolSize])); });
+        }
+    }
+
+    template <typename T, size_t N>
+    static void benchmarkFixedMatrix(std::ostream& os, const char* type) {
+        std::vector<Matrix<T, N, N>> a, b;
+        std::vector<Vector<T, N>> rhs;
+        for (size_t k = 0; k < poolSize; ++k) {
+            a.push_back(randomFixedMatrix<T, N>());
+            b.push_back(randomFixedMatrix<T, N>());
+            rhs.push_back(ones<T, N>());
+        }
+
+        measure(os, "FixedMatrix", "multiply", type, N,
+            [&](size_t i) { keep(a[i % poolSize] * b[i % poolSize]); });
+        measure(os, "FixedMatrix", "solve", type, N,
+            [&](size_t i) { keep(a[i % poolSize].solveEquations(rhs[i % poolSize])); });
+    }
+
+    template <typename T, size_t N>
+    static void benchmarkBatchSolver(std::ostream& os, const char* type) {
+        const size_t systems = 16384;
+        BatchSolver<T, N> batch(systems);
+        std::vector<Matrix<T, N, N>> a;
+        std::vector<Vector<T, N>> rhs;
+        for (size_t s = 0; s < systems; ++s) {
+            a.push_back(randomFixedMatrix<T, N>());
+            rhs.push_back(ones<T, N>());
+            batch.setSystem(s, a.back(), rhs.back());
+        }
+
+        // The same systems solved one at a time with the fixed-size matrix, as the baseline
+        std::vector<Vector<T, N>> loopSolutions(systems);
+        measure(os, "BatchSolver", "solve_fixed_loop", type, N,
+            [&](size_t) {
+                for (size_t s = 0; s < systems; ++s) {
+                    loopSolutions[s] = a[s].solveEquations(rhs[s]);
+                }
+                keep(loopSolutions[0]);
+            }, systems);
+        measure(os, "BatchSolver", "solve", type, N,
+            [&](size_t) { batch.solve(1); keep(batch.solutions[0]); }, systems);
+        measure(os, "BatchSolver", "solve_threaded", type, N,
+            [&](size_t) { batch.solve(); keep(batch.solutions[0]); }, systems);
+    }
+
+    static void benchmarkMatrix(std::ostream& os) {
+        const std::vector<size_t> floatingSizes = { 2, 3, 4, 8, 16, 32 };
+        benchmarkDynamicMatrix<double>(os, "double", floatingSizes);
+        benchmarkDynamicMatrix<float>(os, "float", floatingSizes);
+        benchmarkDynamicMatrix<Rational<long long>>(os, "Rational<long long>", { 2, 3 });
+
+        benchmarkFixedMatrix<double, 2>(os, "double");
+        benchmarkFixedMatrix<double, 3>(os, "double");
+        benchmarkFixedMatrix<double, 4>(os, "double");
+        benchmarkFixedMatrix<float, 2>(os, "float");
+        benchmarkFixedMatrix<float, 3>(os, "float");
+        benchmarkFixedMatrix<float, 4>(os, "float");
+
+        benchmarkBatchSolver<double, 2>(os, "double");
+        benchmarkBatchSolver<double, 3>(os, "double");
+        benchmarkBatchSolver<double, 4>(os, "double");
+        benchmarkBatchSolver<float, 2>(os, "float");
+        benchmarkBatchSolver<float, 3>(os, "float");
+        benchmarkBatchSolver<float, 4>(os, "float");
+    }
+};
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Hot-path counters and per-operation timers, both opt-in at compile time.
+// LAB2_INSTRUMENTATION enables the per-thread counters and the counting
+// limb allocator. LAB2_INSTRUMENTATION_TIMING separately enables the timers,
+// which read the clock and so cost far more than a counter. Timers record self
+// time: a nested timed call is charged to its own operation and subtracted
+// from the caller's, so the totals add up to the time spent. Without these
+// switches the INSTRUMENT_* macros expand to nothing and LongInteger keeps the
+// plain std::allocator.
+class Instrumentation {
+public:
+    enum Counter {
+        LimbAllocations,
+        GcdCalls,
+        MultiplySingleLimb,
+        MultiplySchoolbook,
+        CounterCount
+    };
+
+    enum Operation {
+        LongIntegerAdd,
+        LongIntegerSubtract,
+        LongIntegerMultiply,
+        LongIntegerDivide,
+        LongIntegerModulo,
+        RationalSimplify,
+        MatrixMultiply,
+        MatrixSolve,
+        BatchSolve,
+        OperationCount
+    };
+
+    static void count(Counter counter) {
+        increase(local().counters[counter], 1);
+    }
+
+    static void record(Operation operation, unsigned long long nanoseconds) {
+        ThreadStats& stats = local();
+        increase(stats.calls[operation], 1);
+        increase(stats.nanoseconds[operation], nanoseconds);
+    }
+
+    // Clears the totals of every thread. Meant to be called while no
+    // instrumented work is running, or increments made meanwhile may survive.
+    static void reset() {
+        Registry& threads = registry();
+        std::lock_guard<std::mutex> lock(threads.mutex);
+        threads.retired = Totals();
+        for (ThreadStats* stats : threads.active) {
+            stats->clear();
+        }
+    }
+
+    // Writes all counters and timers, summed over threads, as a single JSON object
+    static void report(std::ostream& os) {
+        Totals totals = collect();
+
+        os << "{\"counters\":{";
+        for (int i = 0; i < CounterCount; ++i) {
+            os << (i ? "," : "") << "\"" << counterName(Counter(i)) << "\":" << totals.counters[i];
+        }
+
+        os << "},\"operations\":{";
+        for (int i = 0; i < OperationCount; ++i) {
+            unsigned long long calls = totals.calls[i];
+            unsigned long long nanoseconds = totals.nanoseconds[i];
+            os << (i ? "," : "") << "\"" << operationName(Operation(i)) << "\":{\"calls\":" << calls
+               << ",\"ns_self\":" << nanoseconds
+               << ",\"ns_per_call\":" << (calls ? double(nanoseconds) / calls : 0.0) << "}";
+        }
+        os << "}}";
+    }
+
+    // Records the lifetime of the enclosing scope against an operation, less the
+    // time spent in timed scopes nested inside it. Each timer links to the one
+    // enclosing it on the same thread and hands its elapsed time up on exit.
+    class ScopedTimer {
+    public:
+        ScopedTimer(Operation op) : operation(op), parent(current()), childNanoseconds(0) {
+            current() = this;
+            start = std::chrono::steady_clock::now();
+        }
+
+        ~ScopedTimer() {
+            std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+            unsigned long long nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            current() = parent;
+            if (parent) {
+                parent->childNanoseconds += nanoseconds;
+            }
+            record(operation, nanoseconds > childNanoseconds ? nanoseconds - childNanoseconds : 0);
+        }
+
+    private:
+        Operation operation;
+        ScopedTimer* parent;
+        unsigned long long childNanoseconds;
+        std::chrono::steady_clock::time_point start;
+
+        static ScopedTimer*& current() {
+            static thread_local ScopedTimer* value = nullptr;
+            return value;
+        }
+    };
+
+private:
+    struct Totals {
+        unsigned long long counters[CounterCount];
+        unsigned long long calls[OperationCount];
+        unsigned long long nanoseconds[OperationCount];
+
+        Totals() : counters(), calls(), nanoseconds() {
+        }
+    };
+
+    // Counters and timers of one thread, on cache lines of their own. Only the
+    // owning thread writes them, so an update is a plain load and store instead
+    // of a locked read-modify-write on a line shared by every thread. The values
+    // stay atomic so report() and reset() can read and clear them meanwhile.
+    struct alignas(64) ThreadStats {
+        std::atomic<unsigned long long> counters[CounterCount];
+        std::atomic<unsigned long long> calls[OperationCount];
+        std::atomic<unsigned long long> nanoseconds[OperationCount];
+
+        ThreadStats() {
+            clear();
+            Registry& threads = registry();
+            std::lock_guard<std::mutex> lock(threads.mutex);
+            threads.active.push_back(this);
+        }
+
+        // An exiting thread leaves its totals behind in the registry
+        ~ThreadStats() {
+            Registry& threads = registry();
+            std::lock_guard<std::mutex> lock(threads.mutex);
+            addTo(threads.retired);
+            threads.active.erase(std::find(threads.active.begin(), threads.active.end(), this));
+        }
+
+        void clear() {
+            for (int i = 0; i < CounterCount; ++i) {
+                counters[i].store(0, std::memory_order_relaxed);
+            }
+            for (int i = 0; i < OperationCount; ++i) {
+                calls[i].store(0, std::memory_order_relaxed);
+                nanoseconds[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        void addTo(Totals& totals) const {
+            for (int i = 0; i < CounterCount; ++i) {
+                totals.counters[i] += counters[i].load(std::memory_order_relaxed);
+            }
+            for (int i = 0; i < OperationCount; ++i) {
+                totals.calls[i] += calls[i].load(std::memory_order_relaxed);
+                totals.nanoseconds[i] += nanoseconds[i].load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ThreadStats*> active;
+        Totals retired;
+    };
+
+    static Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    // The calling thread's block. The pointer is constant-initialized, so the hot
+    // path is a thread-local load and a test; the block itself is created and
+    // registered on the first use in each thread.
+    static ThreadStats& local() {
+        static thread_local ThreadStats* stats = nullptr;
+        if (!stats) {
+            stats = &attach();
+        }
+        return *stats;
+    }
+
+    static ThreadStats& attach() {
+        static thread_local ThreadStats stats;
+        return stats;
+    }
+
+    static void increase(std::atomic<unsigned long long>& value, unsigned long long amount) {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static Totals collect() {
+        Registry& threads = registry();
+        std::lock_guard<std::mutex> lock(threads.mutex);
+        Totals totals = threads.retired;
+        for (const ThreadStats* stats : threads.active) {
+            stats->addTo(totals);
+        }
+        return totals;
+    }
+
+    static const char* counterName(Counter counter) {
+        static const char* const names[CounterCount] = {
+            "limb_allocations", "gcd_calls", "multiply_single_limb", "multiply_schoolbook"
+        };
+        return names[counter];
+    }
+
+    static const char* operationName(Operation operation) {
+        static const char* const names[OperationCount] = {
+            "long_integer_add", "long_integer_subtract", "long_integer_multiply", "long_integer_divide",
+            "long_integer_modulo", "rational_simplify", "matrix_multiply", "matrix_solve", "batch_solve"
+        };
+        return names[operation];
+    }
+};
+
+// std::allocator that counts every buffer it hands out as a limb allocation
+template <typename T>
+struct CountingAllocator {
+    typedef T value_type;
+
+    CountingAllocator() {
+    }
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {
+    }
+
+    T* allocate(size_t n) {
+        Instrumentation::count(Instrumentation::LimbAllocations);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* pointer, size_t n) {
+        std::allocator<T>().deallocate(pointer, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const {
+        return false;
+    }
+};
+
+#ifdef LAB2_INSTRUMENTATION
+template <typename T>
+using LimbAllocator = CountingAllocator<T>;
+
+#define INSTRUMENT_COUNT(counter) Instrumentation::count(Instrumentation::counter)
+#else
+template <typename T>
+using LimbAllocator = std::allocator<T>;
+
+#define INSTRUMENT_COUNT(counter) ((void)0)
+#endif
+
+#ifdef LAB2_INSTRUMENTATION_TIMING
+#define INSTRUMENT_TIME(operation) Instrumentation::ScopedTimer instrumentationTimer(Instrumentation::operation)
+#else
+#define INSTRUMENT_TIME(operation) ((void)0)
+#endif
@@ -1,12 +1,18 @@
+#pragma once
+
 #include <iostream>
 #include <vector>
 
+#include "Instrumentation.cpp"
+
 class LongInteger {
 private:
     static const int BASE = 10000;  // Basis for representing digits (10^4)
     static const int WIDTH = 4;     // Width of each digit
 
-    std::vector<int> digits;        // Vector to store the digits
+    typedef std::vector<int, LimbAllocator<int>> Limbs;
+
+    Limbs digits;                   // Vector to store the digits
 
 public:
     // Constructor
@@ -19,6 +25,7 @@ public:
 
     // Addition operator
     LongInteger operator+(const LongInteger& other) const {
+        INSTRUMENT_TIME(LongIntegerAdd);
         LongInteger result;
         int carry = 0;
         int size = std::max(digits.size(), other.digits.size());
@@ -38,6 +45,7 @@ public:
 
     // Subtraction operator
     LongInteger operator-(const LongInteger& other) const {
+        INSTRUMENT_TIME(LongIntegerSubtract);
         LongInteger result;
         int carry = 0;
         int size = digits.size();
@@ -66,8 +74,14 @@ public:
 
     // Multiplication operator
     LongInteger operator*(const LongInteger& other) const {
+        INSTRUMENT_TIME(LongIntegerMultiply);
+        if (digits.size() <= 1 || other.digits.size() <= 1)
+            INSTRUMENT_COUNT(MultiplySingleLimb);
+        else
+            INSTRUMENT_COUNT(MultiplySchoolbook);
+
         int size = digits.size() + other.digits.size();
-        std::vector<int> resultDigits(size, 0);
+        Limbs resultDigits(size, 0);
 
         for (int i = 0; i < digits.size(); ++i) {
             int carry = 0;
@@ -91,6 +105,7 @@ public:
 
     // Division operator
     LongInteger operator/(const LongInteger& other) const {
+        INSTRUMENT_TIME(LongIntegerDivide);
         if (other == 0)
             throw std::runtime_error("Division by zero");
 
@@ -115,6 +130,7 @@ public:
 
     // Modulo operator
     LongInteger operator%(const LongInteger& other) const {
+        INSTRUMENT_TIME(LongIntegerModulo);
         LongInteger dividend = *this;
         LongInteger divisor = other;
         LongInteger quotient, remainder;
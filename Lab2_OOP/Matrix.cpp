@@ -1,8 +1,22 @@
+#pragma once
+
 #include <iostream>
 #include <vector>
+#include <stdexcept>
+#include <utility>
+#include <initializer_list>
+#include <type_traits>
+
+#include "Instrumentation.cpp"
+#include "Vector.cpp"
+
+// Rows and Columns of 0 select the runtime-sized, heap-backed matrix; any other
+// pair selects the fixed-size, stack-backed variant defined below.
+template <typename T, size_t Rows = 0, size_t Columns = 0>
+class Matrix;
 
 template <typename T>
-class Matrix {
+class Matrix<T, 0, 0> {
 private:
     
     size_t rows;
@@ -51,6 +65,7 @@ public:
 
     // Multiplication operator
     Matrix<T> operator*(const Matrix<T>& other) const {
+        INSTRUMENT_TIME(MatrixMultiply);
         if (columns != other.rows) {
             throw std::runtime_error("Matrix dimensions are incompatible for multiplication");
         }
@@ -88,6 +103,7 @@ public:
     }
 
     std::vector<T> solveEquations(const std::vector<T>& b) const {
+        INSTRUMENT_TIME(MatrixSolve);
         if (rows != columns || rows != b.size()) {
             throw std::invalid_argument("Matrix dimensions are not compatible for solving equations.");
         }
@@ -139,3 +155,252 @@ public:
     }
 };
 
+template <typename T, size_t Rows, size_t Columns>
+class Matrix {
+    static_assert(Rows > 0 && Columns > 0, "Fixed-size matrix dimensions must be positive");
+
+public:
+    T elements[Rows][Columns];
+
+
+    // Constructors
+    constexpr Matrix() : elements{} {
+    }
+
+    constexpr Matrix(const T (&values)[Rows][Columns]) : elements{} {
+        for (size_t i = 0; i < Rows; ++i) {
+            for (size_t j = 0; j < Columns; ++j) {
+                elements[i][j] = values[i][j];
+            }
+        }
+    }
+
+    // Conversion from the runtime-sized matrix
+    explicit Matrix(const Matrix<T>& other) : elements{} {
+        if (other.elements.size() != Rows || other.elements[0].size() != Columns) {
+            throw std::runtime_error("Matrix dimensions do not match");
+        }
+
+        for (size_t i = 0; i < Rows; ++i) {
+            for (size_t j = 0; j < Columns; ++j) {
+                elements[i][j] = other.elements[i][j];
+            }
+        }
+    }
+
+    // Conversion to the runtime-sized matrix
+    operator Matrix<T>() const {
+        Matrix<T> result(Rows, Columns);
+        for (size_t i = 0; i < Rows; ++i) {
+            for (size_t j = 0; j < Columns; ++j) {
+                result.elements[i][j] = elements[i][j];
+            }
+        }
+
+        return result;
+    }
+
+    // Addition operator
+    constexpr Matrix operator+(const Matrix& other) const {
+        return add(other, std::make_index_sequence<Rows * Columns>());
+    }
+
+    // Subtraction operator
+    constexpr Matrix operator-(const Matrix& other) const {
+        return subtract(other, std::make_index_sequence<Rows * Columns>());
+    }
+
+    // Multiplication operator, only declared for conforming dimensions
+    template <size_t OtherColumns>
+    constexpr Matrix<T, Rows, OtherColumns> operator*(const Matrix<T, Columns, OtherColumns>& other) const {
+        return multiply(other, std::make_index_sequence<Rows * OtherColumns>());
+    }
+
+    // Matrix-vector product
+    constexpr Vector<T, Rows> operator*(const Vector<T, Columns>& vec) const {
+        Matrix<T, Columns, 1> column;
+        for (size_t k = 0; k < Columns; ++k) {
+            column.elements[k][0] = vec.elements[k];
+        }
+
+        Matrix<T, Rows, 1> product = *this * column;
+        Vector<T, Rows> result;
+        for (size_t i = 0; i < Rows; ++i) {
+            result.elements[i] = product.elements[i][0];
+        }
+
+        return result;
+    }
+
+    // Products with the runtime-sized types, dimensions checked at run time
+    Matrix<T> operator*(const Matrix<T>& other) const {
+        Matrix<T> dynamic = *this;
+        return dynamic * other;
+    }
+
+    Vector<T> operator*(const Vector<T>& vec) const {
+        if (vec.elements.size() != Columns) {
+            throw std::runtime_error("Matrix dimensions are incompatible for multiplication");
+        }
+
+        Vector<T> result(Rows);
+        for (size_t i = 0; i < Rows; ++i) {
+            for (size_t k = 0; k < Columns; ++k) {
+                result.elements[i] += elements[i][k] * vec.elements[k];
+            }
+        }
+
+        return result;
+    }
+
+    constexpr T (&operator[](size_t index))[Columns] {
+        return elements[index];
+    }
+
+    constexpr const T (&operator[](size_t index) const)[Columns] {
+        return elements[index];
+    }
+
+    // Output operator
+    friend std::ostream& operator<<(std::ostream& os, const Matrix& matrix) {
+        for (const auto& row : matrix.elements) {
+            for (const auto& element : row) {
+                os << element << " ";
+            }
+            os << std::endl;
+        }
+        return os;
+    }
+
+    // Closed form (Cramer's rule) for 2x2 and 3x3, Gaussian elimination on the stack otherwise
+    constexpr Vector<T, Rows> solveEquations(const Vector<T, Rows>& b) const {
+        static_assert(Rows == Columns, "Only square matrices can be solved");
+        return solve(b, std::integral_constant<size_t, Rows>());
+    }
+
+private:
+    // Element-wise helpers, expanded over every index at compile time
+    template <size_t... I>
+    constexpr Matrix add(const Matrix& other, std::index_sequence<I...>) const {
+        Matrix result;
+        (void)std::initializer_list<int>{ ((void)(result.elements[I / Columns][I % Columns] =
+            elements[I / Columns][I % Columns] + other.elements[I / Columns][I % Columns]), 0)... };
+        return result;
+    }
+
+    template <size_t... I>
+    constexpr Matrix subtract(const Matrix& other, std::index_sequence<I...>) const {
+        Matrix result;
+        (void)std::initializer_list<int>{ ((void)(result.elements[I / Columns][I % Columns] =
+            elements[I / Columns][I % Columns] - other.elements[I / Columns][I % Columns]), 0)... };
+        return result;
+    }
+
+    template <size_t OtherColumns, size_t... I>
+    constexpr Matrix<T, Rows, OtherColumns> multiply(const Matrix<T, Columns, OtherColumns>& other, std::index_sequence<I...>) const {
+        Matrix<T, Rows, OtherColumns> result;
+        (void)std::initializer_list<int>{ ((void)(result.elements[I / OtherColumns][I % OtherColumns] =
+            dotProduct(other, I / OtherColumns, I % OtherColumns, std::integral_constant<size_t, Columns - 1>())), 0)... };
+        return result;
+    }
+
+    // Row i of this matrix times column j of other, unrolled over k = K..0
+    template <size_t OtherColumns>
+    constexpr T dotProduct(const Matrix<T, Columns, OtherColumns>& other, size_t i, size_t j, std::integral_constant<size_t, 0>) const {
+        return elements[i][0] * other.elements[0][j];
+    }
+
+    template <size_t OtherColumns, size_t K>
+    constexpr T dotProduct(const Matrix<T, Columns, OtherColumns>& other, size_t i, size_t j, std::integral_constant<size_t, K>) const {
+        return dotProduct(other, i, j, std::integral_constant<size_t, K - 1>()) + elements[i][K] * other.elements[K][j];
+    }
+
+    constexpr Vector<T, Rows> solve(const Vector<T, Rows>& b, std::integral_constant<size_t, 2>) const {
+        const T (&a)[Columns] = elements[0];
+        const T (&c)[Columns] = elements[1];
+        T det = a[0] * c[1] - a[1] * c[0];
+
+        Vector<T, Rows> solution;
+        solution.elements[0] = (b.elements[0] * c[1] - a[1] * b.elements[1]) / det;
+        solution.elements[1] = (a[0] * b.elements[1] - b.elements[0] * c[0]) / det;
+        return solution;
+    }
+
+    constexpr Vector<T, Rows> solve(const Vector<T, Rows>& b, std::integral_constant<size_t, 3>) const {
+        T det = determinant3(elements[0][0], elements[0][1], elements[0][2],
+                             elements[1][0], elements[1][1], elements[1][2],
+                             elements[2][0], elements[2][1], elements[2][2]);
+
+        Vector<T, Rows> solution;
+        solution.elements[0] = determinant3(b.elements[0], elements[0][1], elements[0][2],
+                                            b.elements[1], elements[1][1], elements[1][2],
+                                            b.elements[2], elements[2][1], elements[2][2]) / det;
+        solution.elements[1] = determinant3(elements[0][0], b.elements[0], elements[0][2],
+                                            elements[1][0], b.elements[1], elements[1][2],
+                                            elements[2][0], b.elements[2], elements[2][2]) / det;
+        solution.elements[2] = determinant3(elements[0][0], elements[0][1], b.elements[0],
+                                            elements[1][0], elements[1][1], b.elements[1],
+                                            elements[2][0], elements[2][1], b.elements[2]) / det;
+        return solution;
+    }
+
+    template <size_t N>
+    constexpr Vector<T, Rows> solve(const Vector<T, Rows>& b, std::integral_constant<size_t, N>) const {
+        // Augmented matrix [A|b]
+        Matrix<T, Rows, Columns + 1> augmentedMatrix;
+        for (size_t i = 0; i < Rows; ++i) {
+            for (size_t j = 0; j < Columns; ++j) {
+                augmentedMatrix.elements[i][j] = elements[i][j];
+            }
+            augmentedMatrix.elements[i][Columns] = b.elements[i];
+        }
+
+        // Forward elimination
+        for (size_t i = 0; i + 1 < Rows; ++i) {
+            size_t pivotRow = i;
+            for (size_t j = i + 1; j < Rows; ++j) {
+                if (magnitude(augmentedMatrix.elements[j][i]) > magnitude(augmentedMatrix.elements[pivotRow][i])) {
+                    pivotRow = j;
+                }
+            }
+
+            if (pivotRow != i) {
+                for (size_t k = i; k < Columns + 1; ++k) {
+                    T temp = augmentedMatrix.elements[i][k];
+                    augmentedMatrix.elements[i][k] = augmentedMatrix.elements[pivotRow][k];
+                    augmentedMatrix.elements[pivotRow][k] = temp;
+                }
+            }
+
+            for (size_t j = i + 1; j < Rows; ++j) {
+                T ratio = augmentedMatrix.elements[j][i] / augmentedMatrix.elements[i][i];
+                for (size_t k = i; k < Columns + 1; ++k) {
+                    augmentedMatrix.elements[j][k] -= ratio * augmentedMatrix.elements[i][k];
+                }
+            }
+        }
+
+        // Back substitution
+        Vector<T, Rows> solution;
+        for (size_t i = Rows; i-- > 0;) {
+            solution.elements[i] = augmentedMatrix.elements[i][Columns];
+            for (size_t j = i + 1; j < Rows; ++j) {
+                solution.elements[i] -= augmentedMatrix.elements[i][j] * solution.elements[j];
+            }
+            solution.elements[i] /= augmentedMatrix.elements[i][i];
+        }
+
+        return solution;
+    }
+
+    // Absolute value using only the operators Rational and LongInteger provide
+    static constexpr T magnitude(const T& x) {
+        return T(0) > x ? T(0) - x : x;
+    }
+
+    static constexpr T determinant3(const T& a, const T& b, const T& c,
+                                    const T& d, const T& e, const T& f,
+                                    const T& g, const T& h, const T& i) {
+        return a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    }
+};
@@ -1,5 +1,9 @@
+#pragma once
+
 #include <iostream>
 
+#include "Instrumentation.cpp"
+
 template <typename T>
 class Rational {
 private:
@@ -40,7 +44,15 @@ public:
         return Rational<T>(num, denom);
     }
 
-// Compound assignment: Subtraction
+    // Compound assignment: Addition
+    Rational<T>& operator+=(const Rational<T>& other) {
+        numerator = (numerator * other.denominator) + (other.numerator * denominator);
+        denominator *= other.denominator;
+        simplify();
+        return *this;
+    }
+
+    // Compound assignment: Subtraction
     Rational<T>& operator-=(const Rational<T>& other) {
         numerator = (numerator * other.denominator) - (other.numerator * denominator);
         denominator *= other.denominator;
@@ -99,15 +111,23 @@ public:
 private:
     // Helper function to simplify the rational number
     void simplify() {
+        INSTRUMENT_TIME(RationalSimplify);
         if (numerator != 0) {
             T gcd = computeGCD(numerator, denominator);
             numerator /= gcd;
             denominator /= gcd;
         }
+
+        // Keep the sign in the numerator so cross-product comparisons hold
+        if (T(0) > denominator) {
+            numerator = T(0) - numerator;
+            denominator = T(0) - denominator;
+        }
     }
 
     // Helper function to compute the greatest common divisor (GCD) using Euclid's algorithm
     T computeGCD(T a, T b) {
+        INSTRUMENT_COUNT(GcdCalls);
         bool bnot0 = 0;
         while (b != 0) {
             bnot0 = (b != 0);
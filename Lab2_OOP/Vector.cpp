@@ -1,8 +1,18 @@
+#pragma once
+
 #include <iostream>
 #include <vector>
+#include <stdexcept>
+#include <utility>
+#include <initializer_list>
+
+// A Size of 0 selects the runtime-sized, heap-backed vector; any other Size
+// selects the fixed-size, stack-backed variant defined below.
+template <typename T, size_t Size = 0>
+class Vector;
 
 template <typename T>
-class Vector {
+class Vector<T, 0> {
 private:
     size_t size;
 
@@ -65,3 +75,101 @@ public:
         return os;
     }
 };
+
+template <typename T, size_t Size>
+class Vector {
+    static_assert(Size > 0, "Fixed-size vector must have at least one element");
+
+public:
+    T elements[Size];
+
+
+    // Constructors
+    constexpr Vector() : elements{} {
+    }
+
+    constexpr Vector(const T (&values)[Size]) : elements{} {
+        for (size_t i = 0; i < Size; ++i) {
+            elements[i] = values[i];
+        }
+    }
+
+    // Conversion from the runtime-sized vector
+    explicit Vector(const Vector<T>& other) : elements{} {
+        if (other.elements.size() != Size) {
+            throw std::runtime_error("Vector sizes do not match");
+        }
+
+        for (size_t i = 0; i < Size; ++i) {
+            elements[i] = other.elements[i];
+        }
+    }
+
+    // Conversion to the runtime-sized vector
+    operator Vector<T>() const {
+        Vector<T> result(Size);
+        for (size_t i = 0; i < Size; ++i) {
+            result.elements[i] = elements[i];
+        }
+
+        return result;
+    }
+
+    // Addition operator
+    constexpr Vector operator+(const Vector& other) const {
+        return add(other, std::make_index_sequence<Size>());
+    }
+
+    // Subtraction operator
+    constexpr Vector operator-(const Vector& other) const {
+        return subtract(other, std::make_index_sequence<Size>());
+    }
+
+    // Multiplication operator
+    constexpr Vector operator*(const Vector& other) const {
+        return multiply(other, std::make_index_sequence<Size>());
+    }
+
+    constexpr T& operator[](size_t index) {
+        return elements[index];
+    }
+
+    constexpr const T& operator[](size_t index) const {
+        return elements[index];
+    }
+
+    static constexpr size_t size() {
+        return Size;
+    }
+
+    // Output operator
+    friend std::ostream& operator<<(std::ostream& os, const Vector& vec) {
+        for (const auto& element : vec.elements) {
+            os << element << " ";
+        }
+        return os;
+    }
+
+private:
+    // Element-wise helpers, expanded over every index at compile time
+    template <size_t... I>
+    constexpr Vector add(const Vector& other, std::index_sequence<I...>) const {
+        Vector result;
+        (void)std::initializer_list<int>{ ((void)(result.elements[I] = elements[I] + other.elements[I]), 0)... };
+        return result;
+    }
+
+    template <size_t... I>
+    constexpr Vector subtract(const Vector& other, std::index_sequence<I...>) const {
+        Vector result;
+        (void)std::initializer_list<int>{ ((void)(result.elements[I] = elements[I] - other.elements[I]), 0)... };
+        return result;
+    }
+
+    template <size_t... I>
+    constexpr Vector multiply(const Vector& other, std::index_sequence<I...>) const {
+        Vector result;
+        (void)std::initializer_list<int>{ ((void)(result.elements[I] = elements[I] * other.elements[I]), 0)... };
+        return result;
+    }
+};
@@ -2,11 +2,19 @@
 #include "Rational.cpp"
 #include "Matrix.cpp"
 #include "Vector.cpp"
+#include "BatchSolver.cpp"
+#include "Benchmark.cpp"
 
 #include <iostream>
 #include <vector>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    // Machine-readable benchmark results instead of the demo
+    if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+        return Benchmark::run(std::cout);
+    }
 
-int main() {
     // Test with integer random matrix
     Matrix<LongInteger> randomMatrix(3, 3);
     randomMatrix[0] = { LongInteger(2), LongInteger(-1), LongInteger(1) };
@@ -33,5 +41,36 @@ int main() {
         std::cout << "x" << i + 1 << " = " << solutionRational[i] << std::endl;
     }
 
+    // Test with a fixed-size matrix stored on the stack
+    Matrix<double, 3, 3> fixedMatrix({ { 2, -1, 1 }, { 1, 3, -2 }, { 3, -1, 4 } });
+    Vector<double, 3> bFixed({ 3, 1, 5 });
+    std::cout << "Fixed Matrix:\n" << fixedMatrix << std::endl;
+    std::cout << "Solution:\n";
+    Vector<double, 3> solutionFixed = fixedMatrix.solveEquations(bFixed);
+    for (size_t i = 0; i < solutionFixed.size(); ++i) {
+        std::cout << "x" << i + 1 << " = " << solutionFixed[i] << std::endl;
+    }
+
+    // Test with a fixed-size 4x4 system that needs a row swap on a negative pivot
+    Matrix<double, 4, 4> permutedMatrix({ { 0, 1, 0, 0 }, { -1, 0, 0, 0 }, { 0, 0, 1, 0 }, { 0, 0, 0, 1 } });
+    Vector<double, 4> bPermuted({ 1, 2, 3, 4 });
+    std::cout << "Permuted Matrix:\n" << permutedMatrix << std::endl;
+    std::cout << "Solution:\n" << permutedMatrix.solveEquations(bPermuted) << std::endl;
+
+    // Test with a batch of fixed-size systems, the second of which is singular
+    BatchSolver<double, 3> batch(2);
+    batch.setSystem(0, fixedMatrix, bFixed);
+    batch.setSystem(1, Matrix<double, 3, 3>({ { 1, 2, 3 }, { 2, 4, 6 }, { 1, 1, 1 } }), bFixed);
+    batch.solve();
+    for (size_t s = 0; s < batch.size(); ++s) {
+        std::cout << "Batch system " << s + 1 << ": ";
+        if (batch.isSingular(s)) {
+            std::cout << "singular" << std::endl;
+        }
+        else {
+            std::cout << batch.getSolution(s) << std::endl;
+        }
+    }
+
     return 0;
 }
\ No newline at end of file